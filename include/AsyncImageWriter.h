@@ -0,0 +1,80 @@
+#ifndef ASYNC_IMAGE_WRITER_H
+#define ASYNC_IMAGE_WRITER_H
+
+#include "Image.h"
+#include "WorkQueue.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace image {
+
+struct WriteResult {
+	std::string baseName;
+	std::string outputName; // the file actually written
+	bool ok;
+	double seconds; // encoding and writing, excluding time spent queued
+};
+
+// Encodes images on a worker thread so callers such as the viewer's keyboard
+// handler return at once. submit() keeps a copy of the image, which shares the
+// caller's pixels until either side writes to them, so the caller may go on
+// editing its image while the file is encoded. Writes finish in submission
+// order, each followed by its callback on the worker thread.
+class AsyncImageWriter {
+
+      public:
+
+	using Callback = std::function<void(WriteResult const &)>;
+
+	static std::size_t const DEFAULT_MAX_PENDING = 4;
+
+	// At most maxPending images wait behind the one being written
+	explicit AsyncImageWriter(std::size_t maxPending = DEFAULT_MAX_PENDING);
+	// Finishes every write already submitted
+	~AsyncImageWriter();
+
+	// Queues the image for Image::write(); blocks only while maxPending writes
+	// are already waiting. False once the writer is shutting down.
+	bool submit(Image const & image, std::string const & baseName, WriteOptions const & options, Callback callback = Callback());
+
+	// Blocks until every write submitted so far has finished
+	void flush();
+
+	// Writes submitted but not yet finished
+	std::size_t pending() const;
+
+      private:
+
+	struct Request {
+		Image snapshot;
+		std::string baseName;
+		WriteOptions options;
+		Callback callback;
+	};
+
+	using RequestPointer = std::unique_ptr<Request>;
+
+	void writeRequests();
+
+	WorkQueue<RequestPointer> requests;
+
+	mutable std::mutex pendingMutex;
+	std::condition_variable allWritten;
+	std::size_t pendingCount;
+
+	std::thread worker;
+
+	AsyncImageWriter(AsyncImageWriter const &);
+	AsyncImageWriter & operator=(AsyncImageWriter const &);
+
+}; // class AsyncImageWriter
+
+} // namespace image
+
+#endif // ASYNC_IMAGE_WRITER_H
@@ -0,0 +1,182 @@
+#ifndef BACKGROUND_JOB_H
+#define BACKGROUND_JOB_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace image {
+
+// Runs one job at a time on a worker thread, where only the newest job
+// matters: start() supersedes whatever is running or waiting, and cancel()
+// drops it. A job polls Context::cancelled() between steps to stop early once
+// superseded, and hands results back with Context::publish(), any number of
+// times, e.g. progressively finer images. The owner collects the newest result
+// with takeResult(); results of superseded jobs are discarded.
+template <typename Result>
+class BackgroundJob {
+
+      public:
+
+	class Context {
+
+	      public:
+
+		Context(BackgroundJob & owner, unsigned long jobGeneration)
+		: job(owner)
+		, generation(jobGeneration)
+		{
+		}
+
+		// True once a newer job was started or this one was cancelled
+		bool cancelled() const
+		{
+			return job.generation.load() != generation;
+		}
+
+		// Replaces any result not yet taken; false, dropping the result, once cancelled
+		bool publish(Result result)
+		{
+			std::lock_guard<std::mutex> lock(job.mutex);
+			if(cancelled()) return false;
+
+			job.result = std::move(result);
+			job.hasResult = true;
+			return true;
+		}
+
+	      private:
+
+		BackgroundJob & job;
+		unsigned long const generation;
+
+	}; // class Context
+
+	using Job = std::function<void(Context &)>;
+
+	BackgroundJob()
+	: generation(0)
+	, hasPending(false)
+	, busy(false)
+	, hasResult(false)
+	, stopping(false)
+	, worker(&BackgroundJob::runJobs, this)
+	{
+	}
+
+	// Cancels the current job and waits for the worker to stop
+	~BackgroundJob()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			generation++;
+			hasPending = false;
+			stopping = true;
+		}
+		wake.notify_all();
+		worker.join();
+	}
+
+	// Runs the job once the worker is free, cancelling the one running now
+	// and replacing any still waiting
+	void start(Job newJob)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			generation++;
+			pending = std::move(newJob);
+			hasPending = true;
+			hasResult = false;
+		}
+		wake.notify_all();
+	}
+
+	void cancel()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		generation++;
+		pending = Job();
+		hasPending = false;
+		hasResult = false;
+	}
+
+	// Moves the newest result of the current job into result; false when
+	// nothing was published since the last call
+	bool takeResult(Result & taken)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if(! hasResult) return false;
+
+		taken = std::move(result);
+		hasResult = false;
+		return true;
+	}
+
+	// True until the current job returns or is cancelled
+	bool isRunning() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return hasPending || (busy && runningGeneration == generation.load());
+	}
+
+	// Blocks until the worker has nothing left to run
+	void wait()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		idle.wait(lock, [this] { return ! hasPending && ! busy; });
+	}
+
+      private:
+
+	void runJobs()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		for(;;)
+		{
+			wake.wait(lock, [this] { return stopping || hasPending; });
+			if(stopping) return;
+
+			Job job = std::move(pending);
+			pending = Job();
+			hasPending = false;
+			busy = true;
+			runningGeneration = generation.load();
+
+			lock.unlock();
+			Context context(*this, runningGeneration);
+			job(context);
+			job = Job(); // captured state goes before the next job is picked up
+			lock.lock();
+
+			busy = false;
+			idle.notify_all();
+		}
+	}
+
+	std::atomic<unsigned long> generation; // changed under mutex, read anywhere
+	unsigned long runningGeneration;
+
+	Job pending;
+	bool hasPending;
+	bool busy;
+
+	Result result;
+	bool hasResult;
+
+	bool stopping;
+	mutable std::mutex mutex;
+	std::condition_variable wake, idle;
+
+	std::thread worker; // last, so it starts once everything above is set up
+
+	BackgroundJob(BackgroundJob const &);
+	BackgroundJob & operator=(BackgroundJob const &);
+
+}; // class BackgroundJob
+
+} // namespace image
+
+#endif // BACKGROUND_JOB_H
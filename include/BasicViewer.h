@@ -18,10 +18,16 @@
 #ifndef BASIC_VIEWER_H
 #define BASIC_VIEWER_H
 
+#include "AsyncImageWriter.h"
+#include "BackgroundJob.h"
+#include "DisplayBuffer.h"
 #include "Image.h"
 #include "FractalSet.h"
 #include "ImageProcessor.h"
+#include "ImagePipeline.h"
+#include "ImagePyramid.h"
 
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -38,6 +44,7 @@ struct UserInput {
 	std::string fileExtension;
 	std::string imageFormat;
 	image::Image image;
+	std::string pixelType; // storage type forced with -pixel-type, empty to follow the file
 };
 
 namespace viewer {
@@ -109,11 +116,15 @@ class BasicViewer {
 
 	void setImage(image::Image & p)
 	{
+		pendingEdits.clear();
+		StopRefinement();
+		pyramid.clear();
 		displayedImage = p;
 	}
 
 	image::Image const & getImage()
 	{
+		FinishRefinement();
 		return displayedImage;
 	}
 
@@ -134,6 +145,15 @@ class BasicViewer {
 	//! Cascading callback for usage information
 	void Usage();
 
+	//! Waits for the saves still in progress
+	void FinishWrites()
+	{
+		imageWriter.flush();
+	}
+
+	//! Drops the full-resolution job in progress, keeping the image it started from
+	void StopRefinement();
+
   private:
 
 	bool initialized;
@@ -147,6 +167,67 @@ class BasicViewer {
 	float current_raster_pos[4]; // TODO: what does this do
 
 	image::Image displayedImage;
+	image::ImagePipeline pendingEdits; // keyboard edits not yet applied to displayedImage
+	image::DisplayBuffer displayBuffer; // 8-bit, bottom-up copy of displayedImage for glDrawPixels
+
+	void ApplyPendingEdits();
+
+	// Images over ImagePyramid::PREVIEW_PIXELS are edited as a proxy from their
+	// pyramid, shown at once, while the same edits run at full resolution on
+	// refinement's worker. A newer edit restarts that job with every edit since
+	// displayedImage, whose result then replaces displayedImage and the proxy.
+	// Rows of the final pass of a progressive render, starting at rowBegin
+	struct RefinedRows {
+		int rowBegin;
+		image::Image pixels;
+	};
+
+	struct Refinement {
+		image::Image image;
+		image::ImagePyramid pyramid; // of a final image
+		bool complete; // false for a coarse pass of a progressive render
+		int step; // pixel spacing of the coarse pass in image
+		std::vector<RefinedRows> rows; // of the final pass so far, to copy over image
+	};
+
+	using RefinementJob = image::BackgroundJob<Refinement>;
+
+	// Renders every pixel of a full-resolution image, publishing the coarse
+	// passes whose pixels are at most publishStep apart, then the rows of the
+	// final pass as they finish; false once cancelled
+	using RefinementRender = std::function<bool(image::Image & output, RefinementJob::Context & context, int publishStep)>;
+
+	bool UsesPreview() const;
+
+	// Points proxyImage at the pyramid preview level, unless it already holds edits
+	void PrepareProxy();
+
+	// Restarts the job on displayedImage with refineRender, then refineEdits
+	void StartRefinement();
+
+	// Makes a final result the displayed image
+	void InstallRefinement(Refinement & result);
+
+	// Waits for the job in progress and installs its result
+	void FinishRefinement();
+
+	bool refining; // displayedImage is behind the edits shown
+	bool showingPreview; // displayBuffer last drew previewImage
+	image::ImagePyramid pyramid; // of displayedImage, built on first use
+	image::Image proxyImage; // pyramid preview level with the edits since displayedImage
+	image::Image previewImage; // shown while refining: proxyImage or a coarse render pass
+	int previewStep; // of the coarse pass in previewImage, 0 for proxyImage
+	std::size_t previewRows; // Refinement::rows already copied into previewImage
+	RefinementRender refineRender; // render replacing displayedImage's pixels, if any
+	image::ImagePipeline refineEdits; // edits since displayedImage or refineRender
+	RefinementJob refinement;
+
+	image::AsyncImageWriter imageWriter; // j and O save in the background
+
+	// Submits the displayed image, with every queued edit applied, to imageWriter
+	void SaveDisplayedImage(image::WriteOptions const & options);
+
+	double deepZoomRange; // range of the last deep-zoom Julia render
 
 	static BasicViewer * pBasicViewer;
 
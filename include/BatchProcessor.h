@@ -0,0 +1,92 @@
+#ifndef BATCH_PROCESSOR_H
+#define BATCH_PROCESSOR_H
+
+#include "Image.h"
+#include "ImagePipeline.h"
+#include "Stencil.h"
+#include "WorkQueue.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace image {
+
+struct BatchOptions {
+	std::string operations; // viewer key letters applied in order, e.g. "Cgs"
+	std::vector<std::string> inputs; // image files and/or directories
+	std::vector<std::string> extensions; // extensions kept when scanning directories, empty keeps all
+	std::string outputDirectory;
+	std::string outputFormat; // "jpg" or "exr"
+	std::string compression; // OIIO compression of the output files, empty for the format's default
+	int writeThreads; // OIIO threads per encode, 0 for OIIO's default
+	int maxImagesInFlight; // images loaded but not yet written
+	bool forcePixelType; // store every image as pixelType instead of each file's own format
+	PixelType pixelType;
+};
+
+// Headless counterpart of the viewer's key bindings. Files are decoded,
+// processed and encoded by three threads connected through bounded queues, so
+// I/O of one file overlaps the processing of another, while the number of
+// images held in memory never exceeds maxImagesInFlight.
+class BatchProcessor {
+
+      public:
+
+	BatchProcessor(BatchOptions const & options);
+	~BatchProcessor();
+
+	// Runs the whole batch; false if any file failed
+	bool run();
+
+	static bool isSupportedOperation(char key);
+
+	// Records one viewer operation (H, C, g, G, s, w) in the pipeline; the
+	// stencil is only used by s and w. J renders into the image at once and
+	// drops whatever was recorded before it, since it replaces every pixel.
+	static void addOperation(char key, std::shared_ptr<Stencil const> const & stencil, ImagePipeline & pipeline, Image & image);
+
+      private:
+
+	struct Item {
+		std::string inputPath;
+		std::string outputPath;
+		Image image;
+		bool ok;
+		double megapixels;
+		double loadSeconds, processSeconds, writeSeconds;
+	};
+
+	using ItemPointer = std::unique_ptr<Item>;
+
+	void expandInputs();
+	void readFiles();
+	void processImages();
+	void writeImages();
+
+	void acquireSlot();
+	void releaseSlot();
+
+	void printSummary(double wallSeconds) const;
+
+	BatchOptions options;
+	std::vector<std::string> files;
+	std::shared_ptr<Stencil const> stencil;
+
+	WorkQueue<ItemPointer> loadedQueue, processedQueue;
+	std::vector<ItemPointer> finished;
+
+	std::mutex slotMutex;
+	std::condition_variable slotFreed;
+	int imagesInFlight;
+
+	BatchProcessor(BatchProcessor const &);
+	BatchProcessor & operator=(BatchProcessor const &);
+
+}; // class BatchProcessor
+
+} // namespace image
+
+#endif // BATCH_PROCESSOR_H
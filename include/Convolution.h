@@ -0,0 +1,44 @@
+#ifndef CONVOLUTION_H
+#define CONVOLUTION_H
+
+#include "Stencil.h"
+
+namespace image {
+
+// How the direct convolution kernel treats neighbours outside the image
+enum class ConvolutionBoundary {
+	Bounded, // outside samples are black
+	Circular // outside samples wrap around to the opposite edge
+};
+
+// Direct convolution of interleaved float pixels, computing
+// out(x, y) = sum stencil(dx, dy) * in(x + dx, y + dy) for rows [rowBegin, rowEnd).
+// Rows are processed in parallel; each row is split into an interior span with no
+// boundary checks (AVX2 when the CPU has it, scalar otherwise) and a border span.
+void convolveRows(Stencil const & stencil, float const * input, int width, int height, int channelCount,
+		  ConvolutionBoundary boundary, float * output, int rowBegin, int rowEnd);
+
+// One output row from its 2 * halfwidth + 1 source rows, sourceRows[0] being the row
+// at dy = -halfwidth. A null source row is treated as black, which is how bounded
+// convolution sees rows above and below the image. Stencils close enough to
+// low rank run as one vertical and one horizontal 1D pass per separable term.
+void convolveRow(Stencil const & stencil, float const * const * sourceRows, int width, int channelCount,
+		 ConvolutionBoundary boundary, float * outputRow);
+
+// Stencils whose first k separable terms are within this tolerance of the full
+// weights (see Stencil::getSeparableError) are convolved as k pairs of 1D passes,
+// as long as that takes fewer operations than the 2D loop. 0 only accepts
+// stencils that are separable to float precision.
+void setSeparableTolerance(float tolerance);
+float getSeparableTolerance();
+
+// Number of separable terms convolveRow uses for the stencil, -1 when it runs
+// the full 2D loop
+int separableConvolutionRank(Stencil const & stencil);
+
+// Estimated taps per output value of convolveRow for the stencil
+int convolutionTapCount(Stencil const & stencil);
+
+} // namespace image
+
+#endif // CONVOLUTION_H
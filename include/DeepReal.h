@@ -0,0 +1,164 @@
+#ifndef DEEP_REAL_H
+#define DEEP_REAL_H
+
+#include <cmath>
+#include <string>
+
+namespace image {
+
+// Double-double number: an unevaluated sum hi + lo with |lo| <= ulp(hi) / 2,
+// giving about 32 significant decimal digits. Used for deep-zoom coordinates
+// and reference orbits, where double runs out of digits below ranges of 1e-13.
+struct DeepReal {
+	double hi;
+	double lo;
+
+	DeepReal(double value = 0.0)
+	: hi(value)
+	, lo(0.0)
+	{
+	}
+
+	DeepReal(double high, double low)
+	: hi(high)
+	, lo(low)
+	{
+	}
+
+	double toDouble() const
+	{
+		return hi + lo;
+	}
+
+	// Parses a decimal such as "-0.0381100000000000000000000123" or "1.5e-3"
+	// to full double-double precision; returns false on malformed input.
+	static bool parse(std::string const & text, DeepReal & value);
+};
+
+// Deep-zoom view center
+struct DeepPoint {
+	DeepReal x;
+	DeepReal y;
+};
+
+namespace deep {
+
+// s + e == a + b exactly
+inline DeepReal twoSum(double a, double b)
+{
+	double const s = a + b;
+	double const bb = s - a;
+	double const e = (a - (s - bb)) + (b - bb);
+	return DeepReal(s, e);
+}
+
+// s + e == a + b exactly, requires |a| >= |b|
+inline DeepReal quickTwoSum(double a, double b)
+{
+	double const s = a + b;
+	double const e = b - (s - a);
+	return DeepReal(s, e);
+}
+
+} // namespace deep
+
+inline DeepReal operator+ (DeepReal const & a, DeepReal const & b)
+{
+	DeepReal s = deep::twoSum(a.hi, b.hi);
+	DeepReal const t = deep::twoSum(a.lo, b.lo);
+	s.lo += t.hi;
+	s = deep::quickTwoSum(s.hi, s.lo);
+	s.lo += t.lo;
+	return deep::quickTwoSum(s.hi, s.lo);
+}
+
+inline DeepReal operator- (DeepReal const & a)
+{
+	return DeepReal(-a.hi, -a.lo);
+}
+
+inline DeepReal operator- (DeepReal const & a, DeepReal const & b)
+{
+	return a + (-b);
+}
+
+inline DeepReal operator* (DeepReal const & a, DeepReal const & b)
+{
+	double const p = a.hi * b.hi;
+	double e = std::fma(a.hi, b.hi, -p);
+	e += a.hi * b.lo + a.lo * b.hi;
+	return deep::quickTwoSum(p, e);
+}
+
+inline DeepReal operator/ (DeepReal const & a, DeepReal const & b)
+{
+	// Long division: each quotient digit removes another 53 bits of the remainder
+	double const q1 = a.hi / b.hi;
+	DeepReal remainder = a - b * DeepReal(q1);
+	double const q2 = remainder.hi / b.hi;
+	remainder = remainder - b * DeepReal(q2);
+	double const q3 = remainder.hi / b.hi;
+
+	DeepReal const q = deep::quickTwoSum(q1, q2);
+	return q + DeepReal(q3);
+}
+
+inline bool DeepReal::parse(std::string const & text, DeepReal & value)
+{
+	std::size_t position = 0;
+	bool negative = false;
+	if(position < text.size() && (text[position] == '-' || text[position] == '+'))
+	{
+		negative = text[position] == '-';
+		position++;
+	}
+
+	DeepReal mantissa(0.0);
+	int exponent = 0;
+	bool sawDigit = false;
+	bool sawPoint = false;
+
+	for(; position < text.size(); position++)
+	{
+		char const c = text[position];
+		if(c >= '0' && c <= '9')
+		{
+			mantissa = mantissa * DeepReal(10.0) + DeepReal(double(c - '0'));
+			if(sawPoint) exponent--;
+			sawDigit = true;
+		} else if(c == '.' && ! sawPoint)
+		{
+			sawPoint = true;
+		} else
+		{
+			break;
+		}
+	}
+	if(! sawDigit) return false;
+
+	if(position < text.size() && (text[position] == 'e' || text[position] == 'E'))
+	{
+		std::size_t parsed = 0;
+		try
+		{
+			exponent += std::stoi(text.substr(position + 1), &parsed);
+		} catch(...)
+		{
+			return false;
+		}
+		position += 1 + parsed;
+	}
+	if(position != text.size()) return false;
+
+	DeepReal scale(1.0);
+	for(int i = 0; i < std::abs(exponent); i++)
+		scale = scale * DeepReal(10.0);
+
+	value = exponent < 0 ? mantissa / scale : mantissa * scale;
+	if(negative) value = -value;
+	return true;
+}
+
+} // namespace image
+
+#endif // DEEP_REAL_H
@@ -0,0 +1,81 @@
+#ifndef DISPLAY_BUFFER_H
+#define DISPLAY_BUFFER_H
+
+#include "Image.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace image {
+
+// Persistent 8-bit copy of a displayed image, stored bottom row first as
+// glDrawPixels expects, so a redisplay of an unchanged image costs nothing
+// but the draw itself. update() converts only the rows that changed: the rows
+// marked dirty since the last update, or every row when the image's
+// generation moved on without any being marked. Values are clamped to [0, 1]
+// and rounded to 8 bits in parallel with the SIMD conversions of PixelType.
+//
+// Holds no GL state, so it works the same with no display at all.
+class DisplayBuffer {
+
+      public:
+
+	DisplayBuffer();
+	~DisplayBuffer();
+
+	// Rows [rowBegin, rowEnd) of the image, counted from the top, were
+	// rewritten; the next update() converts only these and any others marked
+	void markDirtyRows(int rowBegin, int rowEnd);
+	void markAllDirty();
+
+	// Brings the buffer up to date with the image, which should be the same
+	// image object every time. Returns false when nothing had to be converted.
+	bool update(Image const & image);
+
+	int getWidth() const
+	{
+		return width;
+	}
+
+	int getHeight() const
+	{
+		return height;
+	}
+
+	int getChannelCount() const
+	{
+		return channelCount;
+	}
+
+	// width * channelCount bytes per row, rows packed with no padding, so
+	// draw with GL_UNPACK_ALIGNMENT 1
+	std::uint8_t const * getData() const
+	{
+		return pixels.data();
+	}
+
+	// Rows converted by the last update(), for reporting
+	int getLastUpdatedRows() const
+	{
+		return lastUpdatedRows;
+	}
+
+      private:
+
+	int width, height, channelCount;
+	std::vector<std::uint8_t> pixels;
+
+	unsigned long imageGeneration; // of the image the buffer last matched
+	bool allDirty;
+	std::vector<char> dirtyRows; // by image row, only read when allDirty is false
+	bool anyRowDirty;
+	int lastUpdatedRows;
+
+	DisplayBuffer(DisplayBuffer const &);
+	DisplayBuffer & operator=(DisplayBuffer const &);
+
+}; // class DisplayBuffer
+
+} // namespace image
+
+#endif // DISPLAY_BUFFER_H
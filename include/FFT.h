@@ -0,0 +1,86 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include "Image.h"
+#include "Stencil.h"
+
+#include <complex>
+#include <vector>
+
+namespace image {
+
+using Complex = std::complex<float>;
+
+// One-dimensional complex FFT of a fixed length. Power-of-two lengths use an
+// iterative radix-2 transform; every other length is handled with Bluestein's
+// chirp-z algorithm on top of a power-of-two plan.
+class FFTPlan {
+
+      public:
+
+	FFTPlan(int size = 1);
+
+	int getSize() const
+	{
+		return size;
+	}
+
+	// In-place transforms of a contiguous sequence of getSize() values.
+	// The inverse is normalized, so forward followed by inverse is identity.
+	void forward(Complex * data, std::vector<Complex> & scratch) const;
+	void inverse(Complex * data, std::vector<Complex> & scratch) const;
+
+	static bool isPowerOfTwo(int n);
+	static int nextPowerOfTwo(int n);
+
+	// Estimated floating point operations per transformed element
+	static float costPerElement(int n);
+
+      private:
+
+	void radix2(Complex * data, bool inverse) const;
+	void bluestein(Complex * data, std::vector<Complex> & scratch) const;
+
+	int size;
+	int paddedSize; // power-of-two length used by the radix-2 stage
+	std::vector<int> bitReversal;
+	std::vector<Complex> twiddles; // exp(-2 pi i k / paddedSize), k < paddedSize / 2
+	std::vector<Complex> chirp; // Bluestein only: exp(-pi i k^2 / size)
+	std::vector<Complex> chirpSpectrum; // Bluestein only: FFT of the conjugate chirp filter
+
+}; // class FFTPlan
+
+// Circular 2D convolution of an image with a Stencil in the frequency domain.
+// The forward transform of the stencil is computed once per image size and
+// reused; channels are packed in pairs into the real and imaginary parts of a
+// single complex transform, since the stencil spectrum is that of a real kernel.
+class FFTConvolver {
+
+      public:
+
+	FFTConvolver(Stencil const & stencil, int width, int height);
+
+	// True when this convolver was built for the same weights and image size
+	bool matches(Stencil const & stencil, int width, int height) const;
+
+	void convolve(Image const & input, Image & output) const;
+
+	// Estimated floating point operations per output pixel for the given sizes
+	static float estimatedCost(int width, int height, int channelCount);
+
+      private:
+
+	// 2D transform of planeCount consecutive width x height planes
+	void transformPlanes(Complex * planes, int planeCount, bool inverse) const;
+
+	int width, height;
+	int halfWidth;
+	std::vector<float> weights;
+	FFTPlan rowPlan, columnPlan;
+	std::vector<Complex> stencilSpectrum;
+
+}; // class FFTConvolver
+
+} // namespace image
+
+#endif // FFT_H
@@ -5,6 +5,7 @@
 #include <cmath>
 #include <vector>
 
+#include "DeepReal.h"
 #include "Warp.h"
 
 
@@ -26,8 +27,56 @@ class ColorLUT {
      std::vector< std::vector<float> > bands;
  };
 
+ class JuliaSet;
+
+ // Pixel rectangle [colBegin, colEnd) x [rowBegin, rowEnd) of an image
+ struct PixelRegion {
+    int colBegin, colEnd;
+    int rowBegin, rowEnd;
+ };
+
+ // Colors every pixel by the distance of its warped point from the origin.
+ // Julia set warps are handed to RenderJuliaSetLUT; any other warp goes
+ // through the generic per-pixel virtual call.
  void ApplyFractalWarpLUT( const Point& center, const double range, const Warp& warp, const ColorLUT& lut, Image& output);
 
+ // ApplyFractalWarpLUT for one region only, run on the calling thread, so callers can
+ // schedule regions of several images themselves. Pixels still map over the whole image.
+ void ApplyFractalWarpLUTRegion( const Point& center, const double range, const Warp& warp, const ColorLUT& lut, Image& output, const PixelRegion& region);
+
+ // Specialized Julia set renderer: several pixels per SIMD register, the power
+ // chosen at compile time for 2, 3 and 4 cycles, lanes stop iterating once their
+ // orbit escapes, and 2D tiles are scheduled dynamically across threads.
+ // Produces the same colors as the generic ApplyFractalWarpLUT path.
+ void RenderJuliaSetLUT( const Point& center, const double range, const JuliaSet& julia, const ColorLUT& lut, Image& output);
+
+ // One pass of a coarse-to-fine RenderJuliaSetLUT. Computes the pixels whose column
+ // and row are multiples of step, except those that are also multiples of coarserStep
+ // (0 for none), which an earlier pass left in output, and fills the step x step block
+ // right of and below each computed pixel with its color. Passes of steps 8, 4, 2, 1,
+ // each with the previous step as coarserStep, compute every pixel once and end with
+ // the image RenderJuliaSetLUT would produce, but for last-bit differences where a pixel
+ // falls in a SIMD lane in one and a scalar lane in the other. Steps must divide 32. Only
+ // rows [rowBegin, rowEnd) are rendered, -1 for the bottom, so a pass can be shown in
+ // bands as they finish; rowBegin must be a multiple of 32. Returns false, rendering
+ // nothing, for powers below 2 and ranges that need the deep-zoom renderer.
+ bool RenderJuliaSetLUTPass( const Point& center, const double range, const JuliaSet& julia, const ColorLUT& lut, Image& output, int step, int coarserStep,
+			     int rowBegin = 0, int rowEnd = -1);
+
+ // Deep-zoom Julia renderer for ranges far below what double coordinates resolve.
+ // The orbit of the view center is iterated once in double-double precision; every
+ // pixel then iterates only its small offset from that reference orbit, in double.
+ // A pixel whose value gets smaller than its offset (the glitch condition) or that
+ // outlives the reference is rebased onto the orbit of the critical point 0; the
+ // number of rebases is the count of the RenderDeepJuliaSetLUT trace span.
+ // Centers are good to about 32 digits, so ranges down to ~1e-30 render cleanly.
+ void RenderDeepJuliaSetLUT( const DeepPoint& center, const double range, const JuliaSet& julia, const ColorLUT& lut, Image& output);
+
+ // The fixed point z = z^power + c of the Julia map with the largest magnitude, to
+ // DeepPoint precision. It is repelling, so it lies on the set's boundary and a view
+ // centered on it shows detail at every depth. The origin for powers below 2.
+ DeepPoint JuliaFixedPoint( const JuliaSet& julia);
+
 class JuliaSet : public Warp {
 public:
 
@@ -36,6 +85,10 @@ public:
 
     Point operator()(const Point& P) const;
 
+    const Point& getConstant() const { return center; }
+    int getIterations() const { return iterations; }
+    int getCycles() const { return cycles; }
+
 private:
 
     Point center;
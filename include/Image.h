@@ -1,13 +1,49 @@
 #ifndef IMAGE_H
 #define IMAGE_H
 
+#include "ImageBuffer.h"
+#include "PixelType.h"
+
+#include <atomic>
+#include <memory>
 #include <string>
 #include <vector>
-#include <fstream> // Required to check if file exists
-
 
 namespace image {
 
+// Per-channel statistics of an image. The histograms are only filled when
+// bins were requested; bin i of channel c covers values whose
+// (value - minValues[c]) / (maxValues[c] - minValues[c]) * (numBins - 1)
+// truncates to i, and stays empty when the channel is constant.
+struct ImageStatistics {
+	long pixelCount;
+	std::vector<double> means;
+	std::vector<double> variances; // population variance
+	std::vector<float> minValues;
+	std::vector<float> maxValues;
+	int numBins;
+	std::vector<std::vector<int>> histograms;
+};
+
+// Combines the moments and extrema of two disjoint sets of pixels; histograms
+// are left alone, since their bins depend on the ranges
+void mergeStatistics(ImageStatistics & into, ImageStatistics const & part);
+
+struct WriteOptions {
+	std::string format = "exr"; // "jpg" or "exr", also the file extension
+	std::string compression; // OIIO "compression" attribute, e.g. zip, piz, dwaa or jpeg:95; empty for the format's default
+	bool forcePixelType = false; // write pixelType instead of the storage type
+	PixelType pixelType = PixelType::Float;
+	int threads = 0; // OIIO encoder threads, 0 for OIIO's default
+};
+
+// Claims the first free name after every existing baseName.N + extension: baseName +
+// extension, baseName.1 + extension, baseName.2 + extension and so on. The
+// directory is scanned once, and the name is created with O_EXCL, so writers
+// running at the same time never choose the same file. Leaves an empty file
+// for the caller to overwrite.
+bool reserveOutputName(std::string const & baseName, std::string const & extension, std::string & outputName);
+
 class Image {
 
   public:
@@ -19,10 +55,23 @@ class Image {
 	~Image();
 
 	void clear();
-	void clear(int width, int height, int channelCount);
+	void clear(int width, int height, int channelCount, PixelType type = PixelType::Float);
 
-	bool load(std::string const & filename);
+	// Like clear(width, height, channelCount) but leaves the pixels undefined,
+	// for callers that overwrite every element. Keeps the buffer if the size
+	// and type match.
+	void allocate(int width, int height, int channelCount, PixelType type = PixelType::Float);
 
+	// Stores the pixels as float, so getRawData() is valid afterwards
+	bool load(std::string const & filename);
+	// Stores the pixels as the given type whatever the file holds
+	bool load(std::string const & filename, PixelType type);
+	// Stores the pixels in the file's own format when it is 8 or 16 bit
+	// integer or half, and as float otherwise
+	bool loadNative(std::string const & filename);
+
+	// Writes to a new file named by reserveOutputName(), never overwriting one
+	bool write(std::string const & baseName, WriteOptions const & options, std::string & outputName) const;
 	bool writeJPG(std::string const & baseName, std::string & outputName) const;
 	bool writeEXR(std::string const & baseName, std::string & outputName) const;
 
@@ -51,19 +100,88 @@ class Image {
 		return getWidth() * getHeight();
 	}
 
+	PixelType getPixelType() const
+	{
+		return pixelType;
+	}
+
+	// Converts the pixels to another storage type; a no-op if they already are
+	void convertTo(PixelType type);
+
+	// Writable pixels in the storage type. Copies share their pixels until one
+	// of them is written, so this first gives the image a private buffer if it
+	// shares one. Handing out the pointer also counts as a modification and
+	// drops any cached statistics; use getPixels() for read-only access. Call
+	// it once before writing from several threads, so they never unshare
+	// concurrently.
+	void * getRawPixels() const
+	{
+		detach();
+		markModified();
+		return pPixels;
+	}
+
+	void const * getPixels() const
+	{
+		return pPixels;
+	}
+
+	// Float views of getRawPixels() and getPixels(), null unless the pixels are
+	// stored as float; callers that need float pixels convertTo() them first
 	float * getRawData() const
 	{
-		return pRawData;
+		return pixelType == PixelType::Float ? static_cast<float *>(getRawPixels()) : nullptr;
 	} // img_data(), retrive pointer to the raw data
 
+	float const * getData() const
+	{
+		return pixelType == PixelType::Float ? static_cast<float const *>(pPixels) : nullptr;
+	}
+
+	// True while the pixels are shared with a copy of this image
+	bool isShared() const
+	{
+		return storage && storage.use_count() > 1;
+	}
+
+	// Call after writing through a getRawData() pointer obtained before the
+	// last getStatistics(), so the cached statistics are not reused
+	void markModified() const
+	{
+		generation++;
+	}
+
+	// Changes whenever the pixels may have changed, so derived copies such as
+	// the viewer's display buffer can tell whether they are still current
+	unsigned long getGeneration() const
+	{
+		return generation;
+	}
+
+	// Mean, variance, min and max of every channel, plus histograms when
+	// numBins > 0, gathered in parallel over the raw data. The result is cached
+	// and reused until the pixels change.
+	ImageStatistics getStatistics(int numBins = 0) const;
+
+	// Adds the pixels to histograms binned over the given channel ranges, so
+	// histograms can be gathered over several images, such as the bands of a
+	// streamed file. The bin count is taken from histograms.
+	void accumulateHistograms(std::vector<float> const & minValues, std::vector<float> const & maxValues,
+				  std::vector<std::vector<int>> & histograms) const;
+
 	void getValue(int iCol, int jRow, std::vector<float> & pixel) const;
 	void setValue(int iCol, int jRow, std::vector<float> const & pixel);
 	//  void interpolated_value( float iCol, float jRow, std::vector<float>& pixel) const;
 
+	// Copies share the pixel buffer until either side writes to it
 	Image(Image const & imageTwo);
 	Image & operator= (Image const & imageTwo);
 
-	//  friend void swap(Image& imageOne, Image& imageTwo);
+	Image(Image && imageTwo);
+	Image & operator= (Image && imageTwo);
+
+	// Exchanges pixels and cached statistics without copying
+	friend void swap(Image & imageOne, Image & imageTwo);
 
 	//  void operator*=(float value);
 	//  void operator/=(float value);
@@ -103,6 +221,8 @@ class Image {
 
 	// bool isValid() const;
 
+	// New float array of the pixels, bottom row first; the caller delete[]s it.
+	// The viewer draws from a DisplayBuffer instead.
 	float * getVerticallyFlippedData() const;
 
     std::vector<float> getChannelAverages() const;
@@ -119,10 +239,29 @@ class Image {
     height,
     channelCount; // Nx, Ny, Nc
     long numElements; // Nsize (width * height * channelCount)
-    float * pRawData; // img_data
+	PixelType pixelType;
+	mutable std::shared_ptr<PixelBuffer> storage; // pooled, 64-byte aligned, shared between copies
+	mutable void * pPixels; // img_data, storage->data()
+
+	bool readFile(std::string const & filename, bool forceType, PixelType type);
+	void detach() const;
+	void adoptStorage(std::size_t elements, PixelType type);
+
+	struct StatisticsCache {
+		unsigned long generation;
+		ImageStatistics statistics;
+	};
+
+	// Bumped whenever the pixels may have changed; the cache is only valid for
+	// the generation it was computed at. Read and replaced with std::atomic_load
+	// and std::atomic_store so concurrent queries on a const image are safe.
+	mutable std::atomic<unsigned long> generation;
+	mutable std::shared_ptr<StatisticsCache const> statisticsCache;
+
+	void copyStatisticsFrom(Image const & other);
 };
 
-//  void swap(Image& imageOne, Image& imageTwo);
+void swap(Image & imageOne, Image & imageTwo);
 
 } // namespace image
 #endif // IMAGE_H
@@ -0,0 +1,100 @@
+#ifndef IMAGE_BUFFER_H
+#define IMAGE_BUFFER_H
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace image {
+
+struct BufferPoolStatistics {
+	long hits; // acquisitions served from the pool
+	long misses; // acquisitions that went to the system allocator
+	long discarded; // releases freed at once because the pool was at its limit
+	std::size_t pooledBytes; // bytes currently waiting in the pool
+	std::size_t highWaterBytes;
+
+	double hitRate() const
+	{
+		return hits + misses > 0 ? (double)hits / (double)(hits + misses) : 0.0;
+	}
+};
+
+// Process-wide pool of 64-byte aligned pixel buffers. Released buffers are kept
+// in buckets by size, so the next image of the same dimensions reuses one
+// instead of going back to the allocator. The pool never holds more than the
+// high-water limit; a release that would exceed it frees the buffer instead.
+class BufferPool {
+
+      public:
+
+	static std::size_t const ALIGNMENT = 64;
+	static std::size_t const DEFAULT_HIGH_WATER_BYTES = 512ul << 20;
+
+	//! The pool is a singleton
+	static BufferPool & Instance();
+
+	// Buffer of at least the given number of bytes, aligned to ALIGNMENT
+	void * acquire(std::size_t bytes);
+	// Hands back a buffer from acquire(bytes)
+	void release(void * data, std::size_t bytes);
+
+	// 0 turns pooling off; lowering the limit frees pooled buffers to fit
+	void setHighWaterBytes(std::size_t bytes);
+	std::size_t getHighWaterBytes() const;
+
+	BufferPoolStatistics getStatistics() const;
+
+	// Frees every pooled buffer
+	void trim();
+
+      private:
+
+	static std::size_t bucketBytes(std::size_t bytes);
+	void trimTo(std::size_t bytes);
+
+	mutable std::mutex poolMutex;
+	std::map<std::size_t, std::vector<void *>> buckets; // free buffers by allocated size
+	std::size_t pooledBytes;
+	std::size_t highWaterBytes;
+	long hits, misses, discarded;
+
+	// Declared private to prevent additional instances
+	BufferPool();
+	BufferPool(BufferPool const &);
+	BufferPool & operator=(BufferPool const &);
+};
+
+// Pixel storage shared by the Image copies that have not been written to yet;
+// the last owner hands the buffer back to the pool
+class PixelBuffer {
+
+      public:
+
+	explicit PixelBuffer(std::size_t bytes);
+	~PixelBuffer();
+
+	void * data() const
+	{
+		return values;
+	}
+
+	// In bytes
+	std::size_t size() const
+	{
+		return byteCount;
+	}
+
+      private:
+
+	void * values;
+	std::size_t byteCount;
+
+	PixelBuffer(PixelBuffer const &);
+	PixelBuffer & operator=(PixelBuffer const &);
+};
+
+} // namespace image
+
+#endif // IMAGE_BUFFER_H
@@ -0,0 +1,83 @@
+#ifndef IMAGE_PIPELINE_H
+#define IMAGE_PIPELINE_H
+
+#include "Image.h"
+#include "Stencil.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace image {
+
+// Lazily recorded chain of image operations. Nothing runs until apply(), which
+// fuses each run of pointwise operations (gamma, contrast normalization,
+// histogram remaps) into a single parallel pass over the pixels.
+//
+// A convolution reads its input through the pointwise operations recorded
+// before it and writes its output through the ones after it, one band of rows
+// at a time, so it is the only step that needs a second buffer. Contrast and
+// equalization depend on statistics of their input, so everything recorded
+// before them is brought up to date first; the statistics then come from the
+// image's cache whenever it is still valid.
+class ImagePipeline {
+
+      public:
+
+	ImagePipeline();
+	~ImagePipeline();
+
+	void addGamma(float gamma);
+	void addContrastTransformation();
+	void addHistogramEqualization(int numBins = DEFAULT_HISTOGRAM_BINS);
+
+	// With fixed statistics instead of those of the step's input, e.g. the
+	// statistics of a whole file when the pipeline runs on one band of it
+	void addContrastTransformation(ImageStatistics const & statistics);
+	void addHistogramEqualization(ImageStatistics const & statistics);
+
+	void addBoundedConvolution(std::shared_ptr<Stencil const> stencil);
+	void addCircularConvolution(std::shared_ptr<Stencil const> stencil);
+
+	bool empty() const;
+	void clear();
+
+	// Records the operations of other after those already recorded
+	void append(ImagePipeline const & other);
+
+	// Runs the recorded operations on the image in place. The recording is
+	// kept, so the same pipeline can be applied to any number of images.
+	void apply(Image & image) const;
+
+	using CancelCheck = std::function<bool()>;
+
+	// As apply(), but polls cancelled() before each pass over the image and
+	// gives up, leaving the image partly processed, once it returns true.
+	// False when the run was cancelled.
+	bool apply(Image & image, CancelCheck const & cancelled) const;
+
+	static int const DEFAULT_HISTOGRAM_BINS = 500;
+
+      private:
+
+	struct Operation {
+		enum Kind {
+			Gamma,
+			Contrast,
+			Equalization,
+			BoundedConvolution,
+			CircularConvolution
+		} kind;
+		float gamma;
+		int numBins;
+		std::shared_ptr<Stencil const> stencil;
+		std::shared_ptr<ImageStatistics const> statistics; // null to measure the input
+	};
+
+	std::vector<Operation> operations;
+
+}; // class ImagePipeline
+
+} // namespace image
+
+#endif // IMAGE_PIPELINE_H
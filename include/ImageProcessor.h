@@ -20,6 +20,24 @@ class ImageProcessor {
 	static void doCircularLinearConvolution(Stencil const & stencil, const Image & imageToReadFrom, Image & imageToWriteTo);
 	static void doBoundedLinearConvolution(Stencil const & stencil, const Image & imageToReadFrom, Image & imageToWriteTo);
 
+	// Both convolutions run stencils within this error of a low-rank approximation
+	// as pairs of 1D passes; see setSeparableTolerance() in Convolution.h
+	static void setSeparableTolerance(float tolerance);
+	static float getSeparableTolerance();
+
+	// Circular convolution runs in the frequency domain once the estimated cost of the
+	// direct loop, or of the 1D passes for a separable stencil, exceeds crossover
+	// times the estimated cost of the FFT path.
+	// A crossover of 0 always picks the FFT, a very large one never does.
+	static void setFFTCrossover(float crossover);
+	static float getFFTCrossover();
+
+	// True if doCircularLinearConvolution would pick the FFT path for this stencil and image
+	static bool usesFFTConvolution(Stencil const & stencil, Image const & image);
+
+	// Smallest half-width of a dense stencil for which the FFT path is picked at the given image size
+	static int getFFTCrossoverHalfwidth(int width, int height, int channelCount);
+
     // Applies contrast transformation on the given image via average and RMS
     static void applyContrastTransformation(const Image & imageToReadFrom, Image & imageToWriteTo);
 
@@ -27,6 +45,11 @@ class ImageProcessor {
 
 
   private:
+
+	static void doDirectCircularLinearConvolution(Stencil const & stencil, const Image & imageToReadFrom, Image & imageToWriteTo);
+	static void doFFTCircularLinearConvolution(Stencil const & stencil, const Image & imageToReadFrom, Image & imageToWriteTo);
+
+	static float fftCrossover;
 }; // class ImageProcessor
 
 } // namespace image
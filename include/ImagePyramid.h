@@ -0,0 +1,53 @@
+#ifndef IMAGE_PYRAMID_H
+#define IMAGE_PYRAMID_H
+
+#include "Image.h"
+
+#include <vector>
+
+namespace image {
+
+// Successively halved copies of an image, for previews that stand in for it
+// while work at full resolution is still running. Level 0 shares the image's
+// pixels; each further level is a float image half the width and height of
+// the one before, rounded up, every pixel the mean of a 2x2 block (edge pixels
+// of odd sizes repeat the last row or column).
+class ImagePyramid {
+
+      public:
+
+	// Default size of a preview, about a million pixels
+	static long const PREVIEW_PIXELS = 1024 * 1024;
+
+	ImagePyramid();
+	~ImagePyramid();
+
+	// Replaces the levels with those of the image, halving until a level has
+	// at most smallestPixels pixels
+	void build(Image const & image, long smallestPixels = PREVIEW_PIXELS);
+
+	void clear();
+
+	int getLevelCount() const
+	{
+		return (int)levels.size();
+	}
+
+	Image const & getLevel(int level) const
+	{
+		return levels[level];
+	}
+
+	// Finest level with at most maxPixels pixels, or the coarsest there is;
+	// -1 when the pyramid is empty
+	int levelFor(long maxPixels) const;
+
+      private:
+
+	std::vector<Image> levels;
+
+}; // class ImagePyramid
+
+} // namespace image
+
+#endif // IMAGE_PYRAMID_H
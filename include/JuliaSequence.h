@@ -0,0 +1,80 @@
+#ifndef JULIA_SEQUENCE_H
+#define JULIA_SEQUENCE_H
+
+#include "FractalSet.h"
+#include "Image.h"
+#include "WorkQueue.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace image {
+
+struct JuliaSequenceOptions {
+	Point center;
+	Point juliaConstant;
+	int cycles;
+	double startRange, endRange; // zoomed geometrically from start to end
+	int startIterations, endIterations; // interpolated along the zoom, in log range
+	int frameCount;
+	int width, height;
+	std::string outputPrefix; // frames are written as <prefix>.0001.<format>, ...
+	std::string format; // "jpg" or "exr"
+	int maxFramesInFlight; // frames allocated but not yet encoded
+};
+
+// Headless renderer for Julia zoom sequences. The tiles of all frames form one
+// work list handed out dynamically, earliest frame first, so threads move on to
+// the next frame while the slow tiles of the current one finish. Finished frames
+// are encoded on a separate thread while rendering continues.
+class JuliaSequenceRenderer {
+
+      public:
+
+	JuliaSequenceRenderer(JuliaSequenceOptions const & options);
+	~JuliaSequenceRenderer();
+
+	// Renders and writes every frame; false if any frame failed to write
+	bool run();
+
+	double frameRange(int frame) const;
+	int frameIterations(int frame) const;
+
+      private:
+
+	struct Frame {
+		int index;
+		Image image;
+		int tilesRemaining;
+	};
+
+	using FramePointer = std::unique_ptr<Frame>;
+
+	Frame * acquireFrame(int frame);
+	void finishTile(Frame * frame);
+	void encodeFrames();
+
+	JuliaSequenceOptions options;
+	int tilesAcross, tilesDown;
+
+	std::mutex frameMutex;
+	std::condition_variable frameReleased;
+	std::vector<FramePointer> frames; // index by frame number, null until allocated
+	int nextFrameToAllocate;
+	int framesInFlight;
+
+	WorkQueue<Frame *> finishedFrames;
+	double totalWork, completedWork; // iteration-weighted, for the time estimate
+	bool allWritten;
+
+	JuliaSequenceRenderer(JuliaSequenceRenderer const &);
+	JuliaSequenceRenderer & operator=(JuliaSequenceRenderer const &);
+
+}; // class JuliaSequenceRenderer
+
+} // namespace image
+
+#endif // JULIA_SEQUENCE_H
@@ -0,0 +1,45 @@
+#ifndef PIXEL_TYPE_H
+#define PIXEL_TYPE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace image {
+
+// Storage format of an image's channel values. Every kernel computes in float;
+// integer types hold [0, 1] scaled to their full range, as OIIO reads them.
+enum class PixelType {
+	UInt8,
+	UInt16,
+	Half,
+	Float
+};
+
+std::size_t pixelTypeSize(PixelType type);
+
+char const * pixelTypeName(PixelType type);
+
+// uint8, uint16, half or float; false for anything else
+bool parsePixelType(std::string const & name, PixelType & type);
+
+// Integer types only hold [0, 1], so results outside it need another type
+inline bool isIntegerPixelType(PixelType type)
+{
+	return type == PixelType::UInt8 || type == PixelType::UInt16;
+}
+
+// Widens count values to float
+void convertToFloat(PixelType type, void const * source, float * destination, std::size_t count);
+
+// Narrows count floats, rounding to nearest even. Integer types clamp to
+// [0, 1] first, and NaN becomes 0.
+void convertFromFloat(PixelType type, float const * source, void * destination, std::size_t count);
+
+// IEEE 754 binary16, bit-exact with the F16C instructions
+float halfToFloat(std::uint16_t value);
+std::uint16_t floatToHalf(float value);
+
+} // namespace image
+
+#endif // PIXEL_TYPE_H
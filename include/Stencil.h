@@ -3,18 +3,35 @@
 
 #include <ctime>
 #include <random>
+#include <vector>
 #include <iostream> //TODO: debug
 #include <iomanip> //TODO: debug
 
 namespace image {
 
+// One rank of a stencil: weights(dx, dy) ~ sum over terms of vertical[dy] * horizontal[dx],
+// both indexed from -halfwidth
+struct SeparableTerm {
+	std::vector<float> vertical;
+	std::vector<float> horizontal;
+};
+
 class Stencil {
 
       public:
 
 	static int const DEFAULT_HALF_WIDTH = 5;
 
+	// Random weights summing to 1, printed to stdout
 	Stencil(int halfwidth = DEFAULT_HALF_WIDTH);
+
+	// Row-major weights, (2 * halfwidth + 1)^2 values starting at (-halfwidth, -halfwidth)
+	Stencil(int halfwidth, std::vector<float> const & weights);
+
+	// Normalized to sum to 1
+	static Stencil gaussian(int halfwidth, float sigma);
+	static Stencil box(int halfwidth);
+
 	~Stencil();
 
 	int getHalfwidth() const
@@ -28,15 +45,40 @@ class Stencil {
 
 	int getIndex(int iCol, int jRow) const;
 
+	// Row-major weights, getSize() values starting at (-halfwidth, -halfwidth)
+	float const * getData() const
+	{
+		return stencil_values.data();
+	}
+
 	void printStencil(void) const;
 
 	// float & operator()(int iCol, int jRow);
 	float const & operator() (int iCol, int jRow) const;
 
+	// Singular value decomposition of the weights, strongest term first. The
+	// first k terms are the best rank-k approximation of the stencil.
+	std::vector<SeparableTerm> const & getSeparableTerms() const
+	{
+		return separable_terms;
+	}
+
+	// Sum of the absolute weights the first rank terms leave out. Convolving
+	// with those terms instead of the stencil changes no output by more than
+	// this times the largest absolute input value, apart from float rounding.
+	float getSeparableError(int rank) const;
+
+	// Fewest terms whose error is within the tolerance
+	int getSeparableRank(float tolerance) const;
+
       private:
 
+	void decompose();
+
 	int half_width;
-	float * stencil_values;
+	std::vector<float> stencil_values;
+	std::vector<SeparableTerm> separable_terms;
+	std::vector<float> separable_errors; // getSeparableError(rank) for every rank up to the full width
 
 }; // class Stencil
 
@@ -0,0 +1,100 @@
+#ifndef STREAM_PROCESSOR_H
+#define STREAM_PROCESSOR_H
+
+#include "Image.h"
+#include "ImagePipeline.h"
+#include "Stencil.h"
+#include "WorkQueue.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace image {
+
+struct StreamOptions {
+	std::string operations; // viewer key letters applied in order: H C g G s w
+	std::string inputPath;
+	std::string outputPath; // format from the extension
+	std::size_t memoryBudgetBytes; // pixel memory held at once, across all threads
+	std::shared_ptr<Stencil const> stencil; // kernel of every s and w step; null draws a random one per step
+};
+
+// Out-of-core counterpart of the batch processor for images too large to hold
+// in memory. The file is read in bands of rows through OIIO's scanline or tile
+// API, each band goes through the operations, and finished rows are written
+// with write_scanlines, each on its own thread with bounded queues between them.
+//
+// Pointwise steps work band by band. A convolution keeps a rolling window of
+// 2 * halfwidth + 1 rows of its input; circular convolution also computes the
+// halfwidth rows at the far end of the image up front. Contrast and
+// equalization need statistics of their whole input, gathered by read-only
+// passes over the file before the final pass: one for contrast, two for
+// equalization, whose bins depend on the range found by the first.
+class StreamProcessor {
+
+      public:
+
+	static std::size_t const DEFAULT_MEMORY_BUDGET_BYTES = 256ul << 20;
+
+	StreamProcessor(StreamOptions const & options);
+	~StreamProcessor();
+
+	// Streams the input through the operations into the output; false on failure
+	bool run();
+
+	static bool isSupportedOperation(char key);
+
+      private:
+
+	struct Band {
+		int rowBegin;
+		Image pixels; // width x rows x channels
+	};
+
+	using BandPointer = std::unique_ptr<Band>;
+
+	// One step of the stream: a run of pointwise operations, or one convolution
+	struct Stage {
+		std::string keys; // pointwise keys; only the first may be C or H
+		ImagePipeline pointwise; // built from keys once their statistics are known
+		std::shared_ptr<Stencil const> stencil; // null for pointwise stages
+		bool circular;
+	};
+
+	class StencilWindow;
+
+	bool openInput();
+	void buildStages();
+	int chooseBandRows() const;
+
+	bool resolveStage(std::size_t stageIndex);
+
+	// Streams the file through the first stageCount stages. The rows either
+	// go to the output file, or, when moments or histograms are given, are
+	// only measured: histograms uses the bins and ranges already set in it.
+	bool runPass(std::size_t stageCount, ImageStatistics * moments, ImageStatistics * histograms);
+
+	void readBands(WorkQueue<BandPointer> & output, bool & ok) const;
+	void computeBands(std::size_t stageCount, WorkQueue<BandPointer> & input, WorkQueue<BandPointer> & output, bool & ok) const;
+	void writeBands(WorkQueue<BandPointer> & input, bool & ok) const;
+
+	// Rows of the input to stages[stageIndex], computed from the file on their
+	// own; used for the far-end rows circular convolution needs first
+	bool computeStageInputRows(std::size_t stageIndex, std::vector<int> const & rows, std::vector<float> & values) const;
+
+	StreamOptions options;
+	int width, height, channelCount;
+	int tileHeight; // 0 for scanline files
+	int bandRows;
+	std::vector<Stage> stages;
+
+	StreamProcessor(StreamProcessor const &);
+	StreamProcessor & operator=(StreamProcessor const &);
+
+}; // class StreamProcessor
+
+} // namespace image
+
+#endif // STREAM_PROCESSOR_H
@@ -0,0 +1,154 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace image {
+
+// Pixel rectangle [colBegin, colEnd) x [rowBegin, rowEnd) handed to parallelForTiles
+struct TileRange {
+	int colBegin, colEnd;
+	int rowBegin, rowEnd;
+};
+
+struct WorkerStatistics {
+	int cpu; // the worker is pinned to, -1 when the OS places it
+	int node; // NUMA node of that CPU, -1 when unknown
+	long chunks; // loop chunks run
+	long steals; // chunk ranges taken from another participant
+	double busySeconds; // inside loop bodies
+	double utilization; // busySeconds over the time since the statistics were reset
+};
+
+// Persistent workers shared by every parallel kernel, in place of a fork and
+// join per loop. A loop is cut into chunks of at most grain indices, and each
+// participant, the workers and the calling thread, starts with a contiguous
+// share of them. A participant runs its own chunks front to back; once they
+// run out it steals the back half of the remaining chunks of another, trying
+// workers on its own NUMA node first. Loops started from several threads at
+// once share the workers; each caller runs chunks of its own loop as well, so
+// a loop finishes even while every worker is busy elsewhere. A loop started
+// from inside a loop body runs serially on the calling thread.
+//
+// The thread count counts the calling thread, so a pool of n never keeps more
+// than n threads busy per loop. It defaults to the CPUs the process may run
+// on, so processes started with taskset or a cpuset share a node without
+// oversubscribing it. The environment variables IMGVIEWER_THREADS=<count> and
+// IMGVIEWER_CPUS=<list>, e.g. 0-7,16-23, set the count and pin the workers.
+class ThreadPool {
+
+      public:
+
+	//! The pool is a singleton
+	static ThreadPool & Instance();
+
+	// Restarts the workers so that loops run on count threads, the caller
+	// included; 0 for one per CPU the process may run on. Call while no loop runs.
+	void setThreadCount(int count);
+
+	int getThreadCount() const
+	{
+		return threadCount;
+	}
+
+	// Pins the workers to these CPUs, ordered by NUMA node so that neighbouring
+	// chunks stay on one node, and restarts them; empty to let the OS place them.
+	// The first CPU is left to the calling thread when there are enough.
+	void setCpus(std::vector<int> const & cpus);
+
+	// Linux CPU list syntax, e.g. "0-3,8,10-11"; false for anything else
+	static bool parseCpuList(std::string const & list, std::vector<int> & cpus);
+
+	// Calls body(chunkBegin, chunkEnd) on consecutive chunks of at most grain
+	// indices that together cover [begin, end), and returns once all have run
+	void parallelFor(long begin, long end, long grain, std::function<void(long, long)> const & body);
+
+	// One entry per worker, then one for the calling threads together
+	std::vector<WorkerStatistics> getStatistics() const;
+	void resetStatistics();
+
+	// Chunks, steals and utilization per worker
+	void printStatistics(std::ostream & out) const;
+
+      private:
+
+	struct Loop;
+	struct Worker;
+
+	void startWorkers();
+	void stopWorkers();
+	void runWorker(int index);
+
+	// Runs chunks of the loop as participant slot until none are left to take or steal
+	void participate(Loop & loop, int slot, Worker & stats);
+
+	int threadCount;
+	std::vector<int> cpus; // in placement order, empty when unpinned
+	std::vector<int> cpuNodes; // NUMA node by CPU number, -1 when unknown
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::shared_ptr<std::vector<std::vector<int>> const> stealOrder; // by slot, the slots to steal from
+	std::unique_ptr<Worker> callers; // statistics of the calling threads
+
+	mutable std::mutex mutex;
+	std::condition_variable wake;
+	std::vector<std::shared_ptr<Loop>> loops; // loops with chunks left to take
+	unsigned long loopsAdded; // lets idle workers tell a new loop from one they gave up on
+	bool stopping;
+
+	std::atomic<std::int64_t> statisticsStart;
+
+	// Declared private to prevent additional instances
+	ThreadPool();
+	ThreadPool(ThreadPool const &);
+	ThreadPool & operator=(ThreadPool const &);
+};
+
+// ThreadPool::Instance().parallelFor
+void parallelFor(long begin, long end, long grain, std::function<void(long, long)> const & body);
+
+// Cuts a width x height image into tiles of at most tileWidth x tileHeight and
+// calls body on each, in parallel, row of tiles after row of tiles
+void parallelForTiles(int width, int height, int tileWidth, int tileHeight, std::function<void(TileRange const &)> const & body);
+
+// Reduces [begin, end) in chunks of at most grain indices: body(chunkBegin,
+// chunkEnd, partial) accumulates into a partial that starts as identity, and
+// the partials are folded with combine(total, partial) in chunk order, so the
+// result does not depend on the thread count or on who ran which chunk
+template <typename T, typename Body, typename Combine>
+T parallelReduce(long begin, long end, long grain, T const & identity, Body const & body, Combine const & combine)
+{
+	if(end <= begin) return identity;
+	grain = grain > 0 ? grain : 1;
+
+	long const chunkCount = (end - begin + grain - 1) / grain;
+	std::vector<T> partials(chunkCount, identity);
+	parallelFor(0, chunkCount, 1, [&](long chunkBegin, long chunkEnd) {
+		for(long chunk = chunkBegin; chunk < chunkEnd; chunk++)
+		{
+			long const first = begin + chunk * grain;
+			body(first, std::min(first + grain, end), partials[chunk]);
+		}
+	});
+
+	T total = identity;
+	for(T const & partial : partials)
+	{
+		combine(total, partial);
+	}
+	return total;
+}
+
+} // namespace image
+
+#endif // THREAD_POOL_H
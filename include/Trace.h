@@ -0,0 +1,182 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Builds with -DIMGVIEWER_TRACE=0 compile every trace point out
+#ifndef IMGVIEWER_TRACE
+#define IMGVIEWER_TRACE 1
+#endif
+
+namespace image {
+
+// One timed span on one thread. Names and categories are string literals.
+struct TraceEvent {
+	char const * name;
+	char const * category;
+	std::int64_t startNanoseconds; // since the tracer was created
+	std::int64_t durationNanoseconds;
+	long pixels; // pixels processed, 0 when not meaningful
+	long bytesAllocated; // pixel buffers newly allocated inside the span
+	long bytesCopied; // pixel bytes duplicated inside the span, e.g. copy-on-write
+	long count; // kernel-specific tally, e.g. rebased deep-zoom orbits; 0 when unused
+};
+
+// Collects TraceEvents in a ring buffer per thread. A thread registers its
+// buffer once, under a lock; after that recording is a plain store and a
+// release of the buffer's write count, so threads never contend. Events
+// past the capacity overwrite the oldest ones of their thread.
+//
+// Tracing starts disabled unless the IMGVIEWER_TRACE environment variable
+// names a file, in which case the Chrome trace is written there and the
+// summary printed when the program exits. Disabled trace points cost one
+// relaxed atomic load.
+class Tracer {
+
+      public:
+
+	static std::size_t const DEFAULT_EVENTS_PER_THREAD = 1 << 16;
+
+	//! The tracer is a singleton
+	static Tracer & Instance();
+
+	void setEnabled(bool on)
+	{
+		enabled.store(on, std::memory_order_relaxed);
+	}
+
+	bool isEnabled() const
+	{
+		return enabled.load(std::memory_order_relaxed);
+	}
+
+	// Applies to the buffers of threads that record their first event afterwards
+	void setEventsPerThread(std::size_t count);
+
+	void record(TraceEvent const & event);
+
+	// Nanoseconds since the tracer was created
+	std::int64_t now() const;
+
+	// Chrome trace-event JSON, for chrome://tracing or Perfetto. Call while no
+	// thread is recording; events still being written may come out torn.
+	bool writeChromeTrace(std::string const & path) const;
+
+	// Calls, time, pixel rate and bytes per span name, longest total first
+	void printSummary(std::ostream & out) const;
+
+	// Drops every recorded event
+	void reset();
+
+	// Where the trace goes at exit, empty for nowhere
+	void setOutputPath(std::string const & path)
+	{
+		outputPath = path;
+	}
+
+	std::string const & getOutputPath() const
+	{
+		return outputPath;
+	}
+
+      private:
+
+	struct ThreadBuffer {
+		int threadIndex;
+		std::vector<TraceEvent> events;
+		std::atomic<std::uint64_t> written; // events ever recorded; the last events.size() are kept
+	};
+
+	ThreadBuffer * registerThread();
+
+	// Recorded events of every thread, oldest first per thread, with their thread index
+	void collect(std::vector<std::pair<int, TraceEvent>> & events) const;
+
+	std::atomic<bool> enabled;
+	std::size_t eventsPerThread;
+	std::string outputPath;
+	std::int64_t const startTime;
+
+	mutable std::mutex threadsMutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> threads; // never shrinks, so thread_local pointers stay valid
+
+	// Declared private to prevent additional instances
+	Tracer();
+	Tracer(Tracer const &);
+	Tracer & operator=(Tracer const &);
+};
+
+#if IMGVIEWER_TRACE
+
+// Times its own lifetime as one event when tracing is enabled at construction.
+// Allocations and copies counted while it is the innermost open scope of its
+// thread are attributed to it.
+class TraceScope {
+
+      public:
+
+	TraceScope(char const * name, char const * category, long pixels = 0)
+	: active(Tracer::Instance().isEnabled())
+	{
+		if(! active) return;
+		begin(name, category, pixels);
+	}
+
+	~TraceScope()
+	{
+		if(active) end();
+	}
+
+	void addPixels(long count)
+	{
+		if(active) event.pixels += count;
+	}
+
+	void addCount(long count)
+	{
+		if(active) event.count += count;
+	}
+
+	// Credit the innermost open scope of the calling thread, if any
+	static void countAllocation(std::size_t bytes);
+	static void countCopy(std::size_t bytes);
+
+      private:
+
+	void begin(char const * name, char const * category, long pixels);
+	void end();
+
+	bool const active;
+	TraceEvent event;
+	TraceScope * parent;
+
+	TraceScope(TraceScope const &);
+	TraceScope & operator=(TraceScope const &);
+};
+
+#else
+
+class TraceScope {
+
+      public:
+
+	TraceScope(char const *, char const *, long = 0) {}
+
+	void addPixels(long) {}
+	void addCount(long) {}
+
+	static void countAllocation(std::size_t) {}
+	static void countCopy(std::size_t) {}
+};
+
+#endif
+
+} // namespace image
+
+#endif // TRACE_H
@@ -0,0 +1,77 @@
+#ifndef WORK_QUEUE_H
+#define WORK_QUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace image {
+
+// Bounded blocking FIFO handing work between pipeline threads. Producers block
+// while the queue is full, consumers block while it is empty, and close() wakes
+// everyone up once no more items will arrive.
+template <typename T>
+class WorkQueue {
+
+      public:
+
+	explicit WorkQueue(std::size_t maxItems)
+	: capacity(maxItems > 0 ? maxItems : 1)
+	, closed(false)
+	{
+	}
+
+	// Blocks while the queue is full; returns false if the queue was closed
+	bool push(T item)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		notFull.wait(lock, [this] { return closed || items.size() < capacity; });
+		if(closed) return false;
+
+		items.push_back(std::move(item));
+		notEmpty.notify_one();
+		return true;
+	}
+
+	// Blocks while the queue is empty; returns false once it is closed and drained
+	bool pop(T & item)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		notEmpty.wait(lock, [this] { return closed || ! items.empty(); });
+		if(items.empty()) return false;
+
+		item = std::move(items.front());
+		items.pop_front();
+		notFull.notify_one();
+		return true;
+	}
+
+	void close()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		closed = true;
+		notEmpty.notify_all();
+		notFull.notify_all();
+	}
+
+	std::size_t size() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return items.size();
+	}
+
+      private:
+
+	std::size_t const capacity;
+	bool closed;
+	std::deque<T> items;
+	mutable std::mutex mutex;
+	std::condition_variable notEmpty, notFull;
+
+}; // class WorkQueue
+
+} // namespace image
+
+#endif // WORK_QUEUE_H